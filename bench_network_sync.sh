@@ -0,0 +1,115 @@
+#!/bin/sh
+# Replay a recorded block range through each coin's blockchain-import into
+# a fresh LMDB and report sync throughput, so regressions show up before a
+# fleet upgrade.
+#
+# usage: ./bench_network_sync.sh [coin...]
+#
+# The import runs offline against an empty data directory. Each coin reads
+# its bootstrap from SYNC_BENCH_BOOTSTRAP_<COIN> (e.g.
+# SYNC_BENCH_BOOTSTRAP_LITENERO), falling back to SYNC_BENCH_BOOTSTRAP.
+# SYNC_BENCH_BLOCKS (default 100000) is the number of blocks replayed; a coin
+# whose import stops short of it is reported as failed. SYNC_BENCH_BUILD picks
+# the build to measure (default release; release-lto and release-pgo come
+# from compile_electronero_network_nodes.sh).
+#
+# The import output of each coin is kept in SYNC_BENCH_LOG_DIR (default
+# sync-bench/) as <coin>.log. With SYNC_BENCH_PERF=1 the import also logs its
+# PERF_TIMER points, and each coin's row is followed by the calls and total
+# time per timer name (in the timer's own unit, ms for plain PERF_TIMER;
+# nested timers overlap). Timings have sub-second resolution with GNU date
+# and whole seconds elsewhere.
+
+TOP=$(cd "$(dirname "$0")" && pwd)
+COINS=${*:-"electronero electroneropulse litenero goldnero crystaleum"}
+SYNC_BENCH_BLOCKS=${SYNC_BENCH_BLOCKS:-100000}
+SYNC_BENCH_BUILD=${SYNC_BENCH_BUILD:-release}
+SYNC_BENCH_LOG_DIR=${SYNC_BENCH_LOG_DIR:-$TOP/sync-bench}
+
+case $(date +%N) in
+*[!0-9]*|"") now() { date +%s; } ;;
+*) now() { date +%s.%N; } ;;
+esac
+
+perf_summary() {
+	# sum "PERF <time> <name>" lines of log $1 per timer name
+	awk '{
+		i = index($0, "PERF ")
+		if (!i)
+			next
+		n = split(substr($0, i + 5), f, " ")
+		if (n < 2 || f[1] !~ /^[0-9]+$/)
+			next
+		total[f[n]] += f[1]
+		calls[f[n]]++
+	}
+	END {
+		for (t in total)
+			printf "    %-44s %10d calls %14d\n", t, calls[t], total[t]
+	}' "$1" | sort -k4 -nr
+}
+
+data_dir=
+trap 'rm -rf "$data_dir"' EXIT
+trap 'exit 130' INT TERM
+
+mkdir -p "$SYNC_BENCH_LOG_DIR" || exit 1
+failed=0
+printf '%-18s %-14s %10s %10s %10s\n' coin build blocks seconds blocks/s
+for coin in $COINS; do
+	var=SYNC_BENCH_BOOTSTRAP_$(echo "$coin" | tr '[:lower:]' '[:upper:]')
+	eval bootstrap=\${$var:-\${SYNC_BENCH_BOOTSTRAP:-}}
+	if [ -z "$bootstrap" ] || [ ! -f "$bootstrap" ]; then
+		echo "$coin: set $var or SYNC_BENCH_BOOTSTRAP to a bootstrap file" >&2
+		failed=1
+		continue
+	fi
+	set -- "$TOP/coins/$coin/build/$SYNC_BENCH_BUILD/bin"/*-blockchain-import
+	if [ ! -x "$1" ]; then
+		echo "$coin: no blockchain-import in build/$SYNC_BENCH_BUILD, build it first" >&2
+		failed=1
+		continue
+	fi
+	import=$1
+	log=$SYNC_BENCH_LOG_DIR/$coin.log
+	# bcutil:INFO for the final block count
+	loglevel='0,bcutil:INFO'
+	if [ "${SYNC_BENCH_PERF:-0}" = 1 ]; then
+		loglevel="$loglevel,perf:DEBUG,perf.*:DEBUG"
+	fi
+
+	data_dir=$(mktemp -d) || exit 1
+	start=$(now)
+	"$import" --input-file "$bootstrap" --data-dir "$data_dir" \
+		--block-stop "$SYNC_BENCH_BLOCKS" --log-level "$loglevel" > "$log" 2>&1
+	status=$?
+	end=$(now)
+	rm -rf "$data_dir"
+	data_dir=
+	if [ $status -ne 0 ]; then
+		echo "$coin: import failed with status $status, see $log" >&2
+		failed=1
+		continue
+	fi
+
+	blocks=$(sed -n 's/.*Number of blocks imported: *\([0-9][0-9]*\).*/\1/p' "$log" | tail -n 1)
+	if [ -z "$blocks" ]; then
+		echo "$coin: could not find the imported block count in $log" >&2
+		failed=1
+		continue
+	fi
+	# a fresh database already holds the genesis block, which is not imported
+	if [ "$blocks" -lt $((SYNC_BENCH_BLOCKS - 1)) ]; then
+		echo "$coin: import stopped at $blocks of $SYNC_BENCH_BLOCKS blocks, bootstrap too short" >&2
+		failed=1
+		continue
+	fi
+	echo "$coin $SYNC_BENCH_BUILD $blocks $start $end" | awk '{
+		s = $5 - $4
+		printf "%-18s %-14s %10d %10.1f %10.1f\n", $1, $2, $3, s, (s > 0 ? $3 / s : 0)
+	}'
+	if [ "${SYNC_BENCH_PERF:-0}" = 1 ]; then
+		perf_summary "$log"
+	fi
+done
+exit $failed
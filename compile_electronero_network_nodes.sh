@@ -1,11 +1,154 @@
-git submodule init && git submodule update && cd coins/electronero
+#!/bin/sh
+# Build every coin of the Electronero network.
+#
+# usage: ./compile_electronero_network_nodes.sh [target]
+#
+#   (none)          plain `make` in each coin, as before
+#   release-static  any other target is passed straight to each coin's Makefile
+#   release-lto     release build with link-time optimization
+#   release-pgo     instrumented build, training run, then a release build
+#                   optimized with the recorded profile (GCC only)
+#
+# release-pgo trains on an import of a pinned block range. Point
+# PGO_BOOTSTRAP_<COIN> (e.g. PGO_BOOTSTRAP_ELECTRONERO) or PGO_BOOTSTRAP at
+# a blockchain.raw exported with <coin>-blockchain-export; PGO_BLOCKS sets
+# how many blocks to import (default 100000). PGO_TRAIN_EXTRA is run after
+# the import with BIN and DATA_DIR exported and has to replay a recorded
+# RPC mix against the instrumented electronerod and wallet-rpc.
+#
+# Only the cmake targets in PGO_TARGETS (default: daemon wallet_rpc_server)
+# are built. Every one of them must run during training: the script stops
+# after training if profile data is missing for any of their own sources.
+set -e
+
+TOP=$(cd "$(dirname "$0")" && pwd)
+COINS="electronero electroneropulse litenero goldnero crystaleum"
+TARGET=${1:-}
+JOBS=${JOBS:-4}
+PGO_BLOCKS=${PGO_BLOCKS:-100000}
+PGO_TARGETS=${PGO_TARGETS:-"daemon wallet_rpc_server"}
+PGO_WARN=
+MAKE_TARGETS=
+
+trap 'exit 130' INT TERM
+
+cmake_release() {
+	# $1 build dir, remaining args are extra cmake definitions; builds
+	# MAKE_TARGETS, or everything when it is empty
+	dir=$1
+	shift
+	mkdir -p "$dir"
+	(cd "$dir" && cmake -D CMAKE_BUILD_TYPE=Release -D BUILD_TESTS=OFF "$@" ../.. && make -j"$JOBS" $MAKE_TARGETS)
+}
+
+pgo_bootstrap() {
+	# sets bootstrap to the training file of coin $1
+	var=PGO_BOOTSTRAP_$(echo "$1" | tr '[:lower:]' '[:upper:]')
+	eval bootstrap=\${$var:-\${PGO_BOOTSTRAP:-}}
+}
+
+pgo_check() {
+	# fail before building anything if release-pgo cannot work
+	if ! "${CXX:-c++}" -v 2>&1 | grep -q '^gcc version'; then
+		echo "release-pgo needs GCC; ${CXX:-c++} is not GCC (clang would also need llvm-profdata merge)" >&2
+		exit 1
+	fi
+	# -Wmissing-profile only exists since GCC 9
+	gcc_major=$("${CXX:-c++}" -dumpversion | cut -d. -f1)
+	if [ "$gcc_major" -ge 9 ]; then
+		PGO_WARN=-Wmissing-profile
+	fi
+	for coin in $COINS; do
+		pgo_bootstrap "$coin"
+		if [ -z "$bootstrap" ] || [ ! -f "$bootstrap" ]; then
+			echo "$coin: set $var or PGO_BOOTSTRAP to a bootstrap file to train on" >&2
+			exit 1
+		fi
+	done
+	if [ -z "${PGO_TRAIN_EXTRA:-}" ] && [ "$PGO_TARGETS" != blockchain_import ]; then
+		echo "release-pgo: set PGO_TRAIN_EXTRA to exercise $PGO_TARGETS during training" >&2
+		exit 1
+	fi
+}
+
+pgo_train() {
+	# $1 coin, $2 bin dir of the instrumented build
+	pgo_bootstrap "$1"
+	BIN=$2
+	DATA_DIR=$(mktemp -d)
+	trap 'rm -rf "$DATA_DIR"' EXIT
+	"$BIN"/*-blockchain-import --input-file "$bootstrap" --data-dir "$DATA_DIR" \
+		--block-stop "$PGO_BLOCKS"
+	if [ -n "${PGO_TRAIN_EXTRA:-}" ]; then
+		(export BIN DATA_DIR; sh -c "$PGO_TRAIN_EXTRA")
+	fi
+	rm -rf "$DATA_DIR"
+	trap - EXIT
+}
+
+pgo_coverage() {
+	# $1 build dir, $2 profile dir; every object of the PGO_TARGETS
+	# themselves must have left a .gcda behind during training
+	gcda=$(find "$2" -name '*.gcda' | tr / '#')
+	for t in $PGO_TARGETS; do
+		objs=$(find "$1" -path "*/CMakeFiles/$t.dir/*" -name '*.o')
+		if [ -z "$objs" ]; then
+			echo "$coin: no objects found for PGO target $t" >&2
+			exit 1
+		fi
+		for o in $objs; do
+			want=$(echo "${o#*/CMakeFiles/}" | sed 's/\.o$/.gcda/' | tr / '#')
+			if ! echo "$gcda" | grep -qF "#$want"; then
+				echo "$coin: no profile for $o, PGO_TRAIN_EXTRA did not run $t" >&2
+				exit 1
+			fi
+		done
+	done
+}
+
+build_coin() {
+	coin=$1
+	case $TARGET in
+	"")
+		make -j"$JOBS"
+		;;
+	release-lto)
+		cmake_release build/release-lto -D USE_LTO=ON
+		;;
+	release-pgo)
+		# GCC names .gcda files after the object path, so both phases
+		# build in the same directory. It is wiped before each phase so
+		# no object outlives the profile it was built against.
+		profile=$PWD/build/pgo-profile
+		rm -rf "$profile" build/release-pgo
+		MAKE_TARGETS="$PGO_TARGETS blockchain_import"
+		cmake_release build/release-pgo \
+			-D CMAKE_C_FLAGS="-fprofile-generate=$profile" \
+			-D CMAKE_CXX_FLAGS="-fprofile-generate=$profile" \
+			-D CMAKE_EXE_LINKER_FLAGS="-fprofile-generate=$profile"
+		pgo_train "$coin" "$PWD/build/release-pgo/bin"
+		pgo_coverage build/release-pgo "$profile"
+		rm -rf build/release-pgo
+		MAKE_TARGETS=$PGO_TARGETS
+		use="-fprofile-use=$profile -fprofile-correction $PGO_WARN"
+		cmake_release build/release-pgo -D USE_LTO=ON \
+			-D CMAKE_C_FLAGS="$use" -D CMAKE_CXX_FLAGS="$use"
+		MAKE_TARGETS=
+		;;
+	*)
+		make -j"$JOBS" "$TARGET"
+		;;
+	esac
+}
+
+if [ "$TARGET" = release-pgo ]; then
+	pgo_check
+fi
+cd "$TOP"
 git submodule init && git submodule update
-make -j4 && cd ../electroneropulse
-git submodule init && git submodule update
-make -j4 && cd ../litenero
-git submodule init && git submodule update
-make -j4 && cd ../goldnero
-git submodule init && git submodule update
-make -j4 && cd coins/crystaleum
-git submodule init && git submodule update && make -j4
+for coin in $COINS; do
+	cd "$TOP/coins/$coin"
+	git submodule init && git submodule update
+	build_coin "$coin"
+done
 echo 'Electronero network compiled ETNX, ETNXP, LTNX, GLDX, CRFI successfully'